@@ -37,6 +37,8 @@
 typedef struct iri_struct iri_t;
 # endif
 
+typedef struct iri_compact_struct iri_compact_t;
+
 struct iri_struct
 {
 	const char *display;
@@ -54,6 +56,45 @@ struct iri_struct
 	size_t nschemes;
 };
 
+/* Components for iri_compact_get() */
+# define IRI_PART_SCHEME               0
+# define IRI_PART_USER                 1
+# define IRI_PART_AUTH                 2
+# define IRI_PART_PASSWORD             3
+# define IRI_PART_HOST                 4
+# define IRI_PART_PATH                 5
+# define IRI_PART_QUERY                6
+# define IRI_PART_ANCHOR               7
+# define IRI_NPARTS                    8
+
+/* Per-thread counters for iri_parse_cached() */
+struct iri_cache_stats
+{
+	unsigned long hits;
+	unsigned long misses;
+	size_t entries;
+	size_t nbytes;
+	size_t limit;
+};
+
+/* Default size limit of each thread's parse cache */
+# define IRI_CACHE_DEFAULT_LIMIT       262144
+
+/* Flags for iri_scheme_register() */
+# define IRI_SCHEME_AUTHORITY          1
+# define IRI_SCHEME_USERINFO           2
+
+/* Flags for iri_validate() */
+# define IRI_VALIDATE_STRICT           0
+# define IRI_VALIDATE_LENIENT          1
+
+/* Components for iri_encode() */
+# define IRI_ENCODE_PATH               0
+# define IRI_ENCODE_QKEY               1
+# define IRI_ENCODE_QVALUE             2
+# define IRI_ENCODE_FRAGMENT           3
+# define IRI_ENCODE_USERINFO           4
+
 # undef EXTERNC_
 # if defined(__cplusplus)
 #  define EXTERNC_                     extern "C"
@@ -62,7 +103,27 @@ struct iri_struct
 # endif
 
 EXTERNC_ iri_t *iri_parse(const char *src);
+EXTERNC_ int iri_scheme_register(const char *name, int default_port, unsigned int flags);
 EXTERNC_ void iri_destroy(iri_t *iri);
 EXTERNC_ iri_t *iri_dup(iri_t *iri);
+EXTERNC_ int iri_validate(const char *src, size_t len, unsigned int flags, size_t *err_offset);
+EXTERNC_ size_t iri_encode(char *dst, const char *src, size_t len, int component);
+EXTERNC_ size_t iri_encode_query(char *dst, const char *const *keys, const char *const *values, size_t count);
+EXTERNC_ iri_t *iri_parse_cached(const char *src);
+EXTERNC_ void iri_cache_limit(size_t nbytes);
+EXTERNC_ void iri_cache_flush(void);
+EXTERNC_ void iri_cache_stats(struct iri_cache_stats *stats);
+EXTERNC_ int iri_set_host(iri_t *iri, const char *host);
+EXTERNC_ int iri_set_path(iri_t *iri, const char *path);
+EXTERNC_ int iri_set_query(iri_t *iri, const char *query);
+EXTERNC_ int iri_set_port(iri_t *iri, int port);
+EXTERNC_ int iri_query_remove(iri_t *iri, const char *key);
+EXTERNC_ size_t iri_size(const iri_t *iri);
+EXTERNC_ iri_compact_t *iri_compact(const iri_t *iri);
+EXTERNC_ iri_compact_t *iri_parse_compact(const char *src);
+EXTERNC_ const char *iri_compact_get(const iri_compact_t *c, int part, size_t *len);
+EXTERNC_ int iri_compact_port(const iri_compact_t *c);
+EXTERNC_ size_t iri_compact_size(const iri_compact_t *c);
+EXTERNC_ void iri_compact_destroy(iri_compact_t *c);
 
 #endif /* !IRI_H_ */
@@ -0,0 +1,294 @@
+/*
+ * libiri: An IRI/URI/URL parsing library
+ * @(#) $Id$
+ */
+
+/*
+ * Copyright (c) 2005, 2008 Mo McRoberts.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ * 3. The names of the author(s) of this software may not be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, 
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY 
+ * AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * AUTHORS OF THIS SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS 
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <pthread.h>
+
+#include "p_libiri.h"
+
+#undef CACHE_BUCKETS
+#define CACHE_BUCKETS 1024
+
+/* Each thread has its own cache, so that lookups never need a lock. The
+ * parsed IRIs themselves are shared with callers by reference count,
+ * which means an entry can be evicted while somebody is still using it.
+ */
+struct iri_cache_entry
+{
+	struct iri_cache_entry *hnext;
+	struct iri_cache_entry *prev, *next;
+	unsigned long hash;
+	size_t len;
+	size_t nbytes;
+	iri_t *iri;
+	char src[1];
+};
+
+struct iri_cache
+{
+	struct iri_cache_entry *buckets[CACHE_BUCKETS];
+	/* Most-recently used at the head */
+	struct iri_cache_entry *head, *tail;
+	/* iri__scheme_gen at the time the entries were parsed */
+	unsigned long scheme_gen;
+	struct iri_cache_stats stats;
+};
+
+static pthread_key_t iri__cache_key;
+static pthread_once_t iri__cache_once = PTHREAD_ONCE_INIT;
+
+static void
+iri__cache_clear(struct iri_cache *cache)
+{
+	struct iri_cache_entry *e, *next;
+	
+	for(e = cache->head; NULL != e; e = next)
+	{
+		next = e->next;
+		iri_destroy(e->iri);
+		free(e);
+	}
+	memset(cache->buckets, 0, sizeof(cache->buckets));
+	cache->head = cache->tail = NULL;
+	cache->stats.nbytes = 0;
+	cache->stats.entries = 0;
+}
+
+static void
+iri__cache_free(void *ptr)
+{
+	iri__cache_clear((struct iri_cache *) ptr);
+	free(ptr);
+}
+
+static void
+iri__cache_init(void)
+{
+	pthread_key_create(&iri__cache_key, iri__cache_free);
+}
+
+static struct iri_cache *
+iri__cache_get(void)
+{
+	struct iri_cache *cache;
+	
+	pthread_once(&iri__cache_once, iri__cache_init);
+	if(NULL == (cache = (struct iri_cache *) pthread_getspecific(iri__cache_key)))
+	{
+		if(NULL == (cache = (struct iri_cache *) calloc(1, sizeof(struct iri_cache))))
+		{
+			return NULL;
+		}
+		cache->stats.limit = IRI_CACHE_DEFAULT_LIMIT;
+		if(0 != pthread_setspecific(iri__cache_key, cache))
+		{
+			free(cache);
+			return NULL;
+		}
+	}
+	return cache;
+}
+
+static inline void
+iri__cache_unlink(struct iri_cache *cache, struct iri_cache_entry *e)
+{
+	if(e->prev)
+	{
+		e->prev->next = e->next;
+	}
+	else
+	{
+		cache->head = e->next;
+	}
+	if(e->next)
+	{
+		e->next->prev = e->prev;
+	}
+	else
+	{
+		cache->tail = e->prev;
+	}
+}
+
+static inline void
+iri__cache_push(struct iri_cache *cache, struct iri_cache_entry *e)
+{
+	e->prev = NULL;
+	e->next = cache->head;
+	if(cache->head)
+	{
+		cache->head->prev = e;
+	}
+	else
+	{
+		cache->tail = e;
+	}
+	cache->head = e;
+}
+
+static void
+iri__cache_evict(struct iri_cache *cache, struct iri_cache_entry *e)
+{
+	struct iri_cache_entry **hp;
+	
+	for(hp = &(cache->buckets[e->hash % CACHE_BUCKETS]); *hp != e; hp = &((*hp)->hnext));
+	*hp = e->hnext;
+	iri__cache_unlink(cache, e);
+	cache->stats.nbytes -= e->nbytes;
+	cache->stats.entries--;
+	iri_destroy(e->iri);
+	free(e);
+}
+
+/* Parse src, returning a previously-parsed copy from this thread's cache
+ * if there is one. The result must be treated as read-only, and released
+ * with iri_destroy() as usual.
+ */
+iri_t *
+iri_parse_cached(const char *src)
+{
+	struct iri_cache *cache;
+	struct iri_cache_entry *e;
+	const unsigned char *s;
+	unsigned long hash, gen;
+	size_t len, nbytes;
+	iri_t *p;
+	
+	if(NULL == (cache = iri__cache_get()) || 0 == cache->stats.limit)
+	{
+		return iri_parse(src);
+	}
+	gen = __atomic_load_n(&iri__scheme_gen, __ATOMIC_ACQUIRE);
+	if(gen != cache->scheme_gen)
+	{
+		/* A scheme has been registered since; results may now differ */
+		iri__cache_clear(cache);
+		cache->scheme_gen = gen;
+	}
+	/* FNV-1a, computing the length on the way through */
+	hash = 2166136261UL;
+	for(s = (const unsigned char *) src; *s; s++)
+	{
+		hash = (hash ^ *s) * 16777619UL;
+	}
+	len = (const char *) s - src;
+	for(e = cache->buckets[hash % CACHE_BUCKETS]; NULL != e; e = e->hnext)
+	{
+		if(e->hash == hash && e->len == len && 0 == memcmp(e->src, src, len))
+		{
+			cache->stats.hits++;
+			if(e != cache->head)
+			{
+				iri__cache_unlink(cache, e);
+				iri__cache_push(cache, e);
+			}
+			__sync_fetch_and_add(&(e->iri->refs), 1);
+			return e->iri;
+		}
+	}
+	cache->stats.misses++;
+	if(NULL == (p = iri_parse(src)))
+	{
+		return NULL;
+	}
+	nbytes = sizeof(struct iri_cache_entry) + len + sizeof(iri_t) + p->nbytes;
+	if(nbytes > cache->stats.limit)
+	{
+		return p;
+	}
+	if(NULL == (e = (struct iri_cache_entry *) malloc(sizeof(struct iri_cache_entry) + len)))
+	{
+		return p;
+	}
+	memcpy(e->src, src, len + 1);
+	e->hash = hash;
+	e->len = len;
+	e->nbytes = nbytes;
+	e->iri = p;
+	p->refs = 1;
+	e->hnext = cache->buckets[hash % CACHE_BUCKETS];
+	cache->buckets[hash % CACHE_BUCKETS] = e;
+	iri__cache_push(cache, e);
+	cache->stats.nbytes += nbytes;
+	cache->stats.entries++;
+	while(cache->stats.nbytes > cache->stats.limit)
+	{
+		iri__cache_evict(cache, cache->tail);
+	}
+	return p;
+}
+
+/* Set the size limit, in bytes, of this thread's cache; 0 disables it */
+void
+iri_cache_limit(size_t nbytes)
+{
+	struct iri_cache *cache;
+	
+	if(NULL == (cache = iri__cache_get()))
+	{
+		return;
+	}
+	cache->stats.limit = nbytes;
+	while(cache->stats.nbytes > cache->stats.limit)
+	{
+		iri__cache_evict(cache, cache->tail);
+	}
+}
+
+/* Discard everything in this thread's cache */
+void
+iri_cache_flush(void)
+{
+	struct iri_cache *cache;
+	
+	if(NULL != (cache = iri__cache_get()))
+	{
+		iri__cache_clear(cache);
+	}
+}
+
+/* Retrieve the counters for this thread's cache */
+void
+iri_cache_stats(struct iri_cache_stats *stats)
+{
+	struct iri_cache *cache;
+	
+	if(NULL == (cache = iri__cache_get()))
+	{
+		memset(stats, 0, sizeof(struct iri_cache_stats));
+		return;
+	}
+	*stats = cache->stats;
+}
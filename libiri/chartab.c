@@ -0,0 +1,77 @@
+/*
+ * libiri: An IRI/URI/URL parsing library
+ * @(#) $Id$
+ */
+
+/*
+ * Copyright (c) 2005, 2008 Mo McRoberts.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ * 3. The names of the author(s) of this software may not be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, 
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY 
+ * AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * AUTHORS OF THIS SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS 
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "p_libiri.h"
+
+/* Shorthand for the combinations which occur in the table below */
+#define RS (IRI__CT_REGNAME|IRI__CT_USERINFO|IRI__CT_PATH|IRI__CT_QUERY)
+#define QS (IRI__CT_QKEY|IRI__CT_QVALUE)
+#define UN (RS|QS|IRI__CT_USER)
+#define SS (IRI__CT_SCHEME|UN)
+#define AL (IRI__CT_ALPHA|SS)
+#define AH (IRI__CT_HEX|AL)
+#define DG (IRI__CT_DIGIT|IRI__CT_HEX|SS)
+#define PL (IRI__CT_SCHEME|RS|IRI__CT_USER)
+#define AM (RS|IRI__CT_USER)
+#define EQ (RS|IRI__CT_QVALUE|IRI__CT_USER)
+#define SC (RS|QS)
+#define CO (IRI__CT_USERINFO|IRI__CT_PATH|IRI__CT_QUERY|QS)
+#define PA (IRI__CT_PATH|IRI__CT_QUERY|QS)
+#define QU (IRI__CT_QUERY|QS)
+#define LX (IRI__CT_LAX)
+
+/* Character classes for 7-bit ASCII; anything with the top bit set is
+ * a UTF-8 sequence byte and is dealt with by the callers.
+ */
+const unsigned short iri__chartab[128] =
+{
+	0,  0,  0,  0,  0,  0,  0,  0,   /* 0x00-0x07 */
+	0,  0,  0,  0,  0,  0,  0,  0,   /* 0x08-0x0f */
+	0,  0,  0,  0,  0,  0,  0,  0,   /* 0x10-0x17 */
+	0,  0,  0,  0,  0,  0,  0,  0,   /* 0x18-0x1f */
+	0,  UN, LX, 0,  UN, 0,  AM, UN,  /*   ! " # $ % & ' */
+	UN, UN, UN, PL, UN, SS, SS, PA,  /* ( ) * + , - . / */
+	DG, DG, DG, DG, DG, DG, DG, DG,  /* 0 1 2 3 4 5 6 7 */
+	DG, DG, CO, SC, LX, EQ, LX, QU,  /* 8 9 : ; < = > ? */
+	PA, AH, AH, AH, AH, AH, AH, AL,  /* @ A B C D E F G */
+	AL, AL, AL, AL, AL, AL, AL, AL,  /* H I J K L M N O */
+	AL, AL, AL, AL, AL, AL, AL, AL,  /* P Q R S T U V W */
+	AL, AL, AL, LX, LX, LX, LX, UN,  /* X Y Z [ \ ] ^ _ */
+	LX, AH, AH, AH, AH, AH, AH, AL,  /* ` a b c d e f g */
+	AL, AL, AL, AL, AL, AL, AL, AL,  /* h i j k l m n o */
+	AL, AL, AL, AL, AL, AL, AL, AL,  /* p q r s t u v w */
+	AL, AL, AL, LX, LX, LX, UN, 0    /* x y z { | } ~   */
+};
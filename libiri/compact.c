@@ -0,0 +1,177 @@
+/*
+ * libiri: An IRI/URI/URL parsing library
+ * @(#) $Id$
+ */
+
+/*
+ * Copyright (c) 2005, 2008 Mo McRoberts.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ * 3. The names of the author(s) of this software may not be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, 
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY 
+ * AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * AUTHORS OF THIS SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS 
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stddef.h>
+
+#include "p_libiri.h"
+
+static inline void
+iri__compact_parts(const iri_t *iri, const char **parts)
+{
+	parts[IRI_PART_SCHEME] = iri->iri.scheme;
+	parts[IRI_PART_USER] = iri->iri.user;
+	parts[IRI_PART_AUTH] = iri->iri.auth;
+	parts[IRI_PART_PASSWORD] = iri->iri.password;
+	parts[IRI_PART_HOST] = iri->iri.host;
+	parts[IRI_PART_PATH] = iri->iri.path;
+	parts[IRI_PART_QUERY] = iri->iri.query;
+	parts[IRI_PART_ANCHOR] = iri->iri.anchor;
+}
+
+/* Return the number of bytes of memory occupied by a parsed IRI, not
+ * counting malloc() overhead.
+ */
+size_t
+iri_size(const iri_t *iri)
+{
+	return sizeof(iri_t) + iri->nbytes;
+}
+
+/* Convert a parsed IRI into the compact representation, which occupies a
+ * single allocation of exactly iri_compact_size() bytes. The scheme list
+ * is not carried over.
+ */
+iri_compact_t *
+iri_compact(const iri_t *iri)
+{
+	const char *parts[IRI_NPARTS];
+	size_t lens[IRI_NPARTS];
+	size_t nspans, datalen, c;
+	iri_compact_t *p;
+	char *data;
+	
+	iri__compact_parts(iri, parts);
+	nspans = 0;
+	datalen = 0;
+	for(c = 0; c < IRI_NPARTS; c++)
+	{
+		if(NULL != parts[c])
+		{
+			lens[c] = strlen(parts[c]);
+			datalen += lens[c] + 1;
+			nspans++;
+		}
+	}
+	if(datalen > UINT32_MAX)
+	{
+		return NULL;
+	}
+	if(NULL == (p = (iri_compact_t *) malloc(offsetof(iri_compact_t, span) + nspans * sizeof(struct iri_compact_span) + datalen)))
+	{
+		return NULL;
+	}
+	p->port = iri->iri.port;
+	p->present = 0;
+	p->nspans = nspans;
+	data = IRI__COMPACT_DATA(p);
+	nspans = 0;
+	datalen = 0;
+	for(c = 0; c < IRI_NPARTS; c++)
+	{
+		if(NULL != parts[c])
+		{
+			p->present |= (1 << c);
+			p->span[nspans].off = datalen;
+			p->span[nspans].len = lens[c];
+			memcpy(data + datalen, parts[c], lens[c] + 1);
+			datalen += lens[c] + 1;
+			nspans++;
+		}
+	}
+	return p;
+}
+
+iri_compact_t *
+iri_parse_compact(const char *src)
+{
+	iri_t *iri;
+	iri_compact_t *p;
+	
+	if(NULL == (iri = iri_parse(src)))
+	{
+		return NULL;
+	}
+	p = iri_compact(iri);
+	iri_destroy(iri);
+	return p;
+}
+
+/* Return the requested component as a NUL-terminated string, storing its
+ * length in *len if non-NULL; or NULL if it isn't present.
+ */
+const char *
+iri_compact_get(const iri_compact_t *c, int part, size_t *len)
+{
+	const struct iri_compact_span *span;
+	unsigned int bit;
+	
+	if(part < 0 || part >= IRI_NPARTS || 0 == (c->present & (bit = 1 << part)))
+	{
+		return NULL;
+	}
+	/* Spans are stored only for the components present, in order */
+	span = &(c->span[__builtin_popcount(c->present & (bit - 1))]);
+	if(NULL != len)
+	{
+		*len = span->len;
+	}
+	return IRI__COMPACT_DATA(c) + span->off;
+}
+
+int
+iri_compact_port(const iri_compact_t *c)
+{
+	return c->port;
+}
+
+size_t
+iri_compact_size(const iri_compact_t *c)
+{
+	size_t datalen;
+	
+	datalen = 0;
+	if(c->nspans)
+	{
+		datalen = c->span[c->nspans - 1].off + c->span[c->nspans - 1].len + 1;
+	}
+	return offsetof(iri_compact_t, span) + c->nspans * sizeof(struct iri_compact_span) + datalen;
+}
+
+void
+iri_compact_destroy(iri_compact_t *c)
+{
+	free(c);
+}
@@ -41,6 +41,11 @@ iri_destroy(iri_t *iri)
 {
 	if(NULL != iri)
 	{
+		if(0 != __sync_fetch_and_sub(&(iri->refs), 1))
+		{
+			/* Still shared with somebody else */
+			return;
+		}
 		free(iri->base);
 		free(iri);
 	}
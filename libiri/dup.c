@@ -68,6 +68,7 @@ iri_dup(iri_t *iri)
 		return NULL;
 	}
 	p->nbytes = iri->nbytes;
+	p->used = iri->used;
 	p->iri.port = iri->iri.port;
 	memcpy(p->base, iri->base, p->nbytes);
 	iri__dupcopy(&(p->iri.display), iri->iri.display, iri->base, iri->nbytes, p->base);
@@ -0,0 +1,163 @@
+/*
+ * libiri: An IRI/URI/URL parsing library
+ * @(#) $Id$
+ */
+
+/*
+ * Copyright (c) 2005, 2008 Mo McRoberts.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ * 3. The names of the author(s) of this software may not be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, 
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY 
+ * AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * AUTHORS OF THIS SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS 
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "p_libiri.h"
+
+/* Characters which may appear unescaped, indexed by IRI_ENCODE_xxx */
+static const unsigned short iri__encmask[] =
+{
+	IRI__CT_PATH,
+	IRI__CT_QKEY,
+	IRI__CT_QVALUE,
+	IRI__CT_QUERY,
+	IRI__CT_USER
+};
+
+static const char iri__hexdigits[] = "0123456789ABCDEF";
+
+/* Return the length of the run of characters at src which can be copied
+ * through unchanged.
+ */
+static inline size_t
+iri__encspan(const unsigned char *src, size_t len, unsigned short mask)
+{
+	size_t c;
+	
+	for(c = 0; c < len; c++)
+	{
+		if(src[c] >= 128 || 0 == (iri__chartab[src[c]] & mask))
+		{
+			break;
+		}
+	}
+	return c;
+}
+
+static size_t
+iri__encode(char *dst, const char *src, size_t len, unsigned short mask)
+{
+	const unsigned char *s, *end;
+	size_t n, run;
+	
+	s = (const unsigned char *) src;
+	end = s + len;
+	n = 0;
+	while(s < end)
+	{
+		run = iri__encspan(s, end - s, mask);
+		if(run)
+		{
+			if(NULL != dst)
+			{
+				memcpy(dst + n, s, run);
+			}
+			n += run;
+			s += run;
+			continue;
+		}
+		if(NULL != dst)
+		{
+			dst[n] = '%';
+			dst[n + 1] = iri__hexdigits[*s >> 4];
+			dst[n + 2] = iri__hexdigits[*s & 15];
+		}
+		n += 3;
+		s++;
+	}
+	return n;
+}
+
+/* Percent-encode len bytes at src for use as the given component, writing
+ * the result and a terminating NUL to dst. Returns the length of the
+ * encoded string, not including the NUL. If dst is NULL, nothing is
+ * written and the exact length is returned, so that callers can size the
+ * buffer (the return value plus one) beforehand. Octets >= 0x80 are always
+ * escaped, so the output is a plain URI. Returns (size_t) -1, writing
+ * nothing, if component isn't one of the IRI_ENCODE_xxx values.
+ */
+size_t
+iri_encode(char *dst, const char *src, size_t len, int component)
+{
+	size_t n;
+	
+	if(component < 0 || component > IRI_ENCODE_USERINFO)
+	{
+		return (size_t) -1;
+	}
+	n = iri__encode(dst, src, len, iri__encmask[component]);
+	if(NULL != dst)
+	{
+		dst[n] = 0;
+	}
+	return n;
+}
+
+/* Encode count key/value pairs as "key=value&key=value..." into dst, in
+ * the same manner as iri_encode(). A NULL value emits the key alone.
+ */
+size_t
+iri_encode_query(char *dst, const char *const *keys, const char *const *values, size_t count)
+{
+	size_t c, n;
+	
+	n = 0;
+	for(c = 0; c < count; c++)
+	{
+		if(c)
+		{
+			if(NULL != dst)
+			{
+				dst[n] = '&';
+			}
+			n++;
+		}
+		n += iri__encode(dst ? dst + n : NULL, keys[c], strlen(keys[c]), IRI__CT_QKEY);
+		if(NULL != values[c])
+		{
+			if(NULL != dst)
+			{
+				dst[n] = '=';
+			}
+			n++;
+			n += iri__encode(dst ? dst + n : NULL, values[c], strlen(values[c]), IRI__CT_QVALUE);
+		}
+	}
+	if(NULL != dst)
+	{
+		dst[n] = 0;
+	}
+	return n;
+}
@@ -38,6 +38,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <stdint.h>
 
 typedef struct iri_internal_struct iri_t;
 
@@ -48,6 +49,75 @@ struct iri_internal_struct
 	struct iri_struct iri;
 	void *base;
 	size_t nbytes;
+	/* Bytes of base in use; anything beyond is slack for the setters */
+	size_t used;
+	/* Number of references held in addition to the creator's, e.g. by
+	 * the parse cache; only ever modified atomically */
+	unsigned long refs;
 };
 
+/* A registered scheme (see scheme.c), immutable once published. word
+ * and mask hold the first (up to) eight bytes of the prefix, packed
+ * little-end first, so that most prefixes can be recognised with a single
+ * comparison.
+ */
+# define IRI__SCHEME_PREFIXLEN         32
+
+struct iri_scheme_info
+{
+	char prefix[IRI__SCHEME_PREFIXLEN];
+	size_t len;
+	size_t plen;
+	int port;
+	unsigned int flags;
+	uint64_t word;
+	uint64_t mask;
+	/* Next on the retired list; only set, under the registration lock,
+	 * once the entry has been superseded and is no longer published */
+	struct iri_scheme_info *retired;
+};
+
+extern const struct iri_scheme_info *iri__scheme_match(const char *src);
+extern const struct iri_scheme_info *iri__scheme_find(const char *name);
+extern unsigned long iri__scheme_gen;
+
+/* Compact representation: a span for each component present (in
+ * IRI_PART_xxx order), followed by the component strings themselves,
+ * each NUL-terminated but otherwise unpadded. Span offsets are relative
+ * to the start of the string data.
+ */
+struct iri_compact_span
+{
+	uint32_t off;
+	uint32_t len;
+};
+
+struct iri_compact_struct
+{
+	int32_t port;
+	uint16_t present;
+	uint16_t nspans;
+	struct iri_compact_span span[1];
+};
+
+# define IRI__COMPACT_DATA(c)          ((char *) &((c)->span[(c)->nspans]))
+
+/* Character classes used by the validator and encoder (see chartab.c) */
+# define IRI__CT_ALPHA                 0x0001
+# define IRI__CT_DIGIT                 0x0002
+# define IRI__CT_HEX                   0x0004
+# define IRI__CT_SCHEME                0x0008
+# define IRI__CT_REGNAME               0x0010
+# define IRI__CT_USERINFO              0x0020
+# define IRI__CT_PATH                  0x0040
+# define IRI__CT_QUERY                 0x0080
+# define IRI__CT_LAX                   0x0100
+# define IRI__CT_QKEY                  0x0200
+# define IRI__CT_QVALUE                0x0400
+# define IRI__CT_USER                  0x0800
+
+extern const unsigned short iri__chartab[128];
+
+# define IRI__CTYPE(c, mask)           ((unsigned char) (c) < 128 && (iri__chartab[(unsigned char) (c)] & (mask)))
+
 #endif /* !P_LIBIRI_H_ */
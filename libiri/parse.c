@@ -189,6 +189,194 @@ iri__allocbuf(const char *src, size_t *len)
 	return (char *) calloc(1, *len);
 }
 
+/* Parse the [/path][?query][#anchor] which ends every IRI, returning the
+ * updated buffer pointer.
+ */
+static inline char *
+iri__parse_path(iri_t *p, char *bufp, const char *src)
+{
+	if(*src == '/')
+	{
+		bufp = ALIGN(bufp);
+		p->iri.path = bufp;
+		while(*src && *src != '?' && *src != '#')
+		{
+			src = iri__copychar_decode(&bufp, src, 0);
+		}
+		*bufp = 0;
+		bufp++;
+	}
+	if(*src == '?')
+	{
+		bufp = ALIGN(bufp);
+		p->iri.query = bufp;
+		src++;
+		while(*src && *src != '#')
+		{
+			/* Don't actually decode the query itself, otherwise it
+			 * can't be reliably split */
+			src = iri__copychar(&bufp, src);
+		}
+		*bufp = 0;
+		bufp++;
+	}
+	if(*src == '#')
+	{
+		bufp = ALIGN(bufp);
+		p->iri.anchor = bufp; 
+		while(*src)
+		{
+			src = iri__copychar_decode(&bufp, src, 0);
+		}
+		*bufp = 0;
+		bufp++;
+	}
+	if(*src)
+	{
+		/* Still stuff left? It must be a path... of sorts */
+		bufp = ALIGN(bufp);
+		p->iri.path = bufp; 
+		while(*src && *src != '?' && *src != '#')
+		{
+			src = iri__copychar_decode(&bufp, src, 0);
+		}
+		*bufp = 0;
+		bufp++;
+	}
+	return bufp;
+}
+
+/* Parser for a registered scheme, whose prefix iri__scheme_match() has
+ * already recognised: the scheme needs no splitting, and the layout of
+ * what follows is known from the registration flags.
+ */
+static iri_t *
+iri__parse_scheme(const char *src, const struct iri_scheme_info *scheme)
+{
+	iri_t *p;
+	char *bufstart, *endp, *bufp, **sl;
+	const char *t;
+	size_t buflen;
+	
+	if(NULL == (p = (iri_t *) calloc(1, sizeof(iri_t))))
+	{
+		return NULL;
+	}
+	if(NULL == (bufstart = iri__allocbuf(src, &buflen)))
+	{
+		free(p);
+		return NULL;
+	}
+	p->base = bufp = bufstart;
+	p->nbytes = buflen;
+	bufp = ALIGN(bufp);
+	p->iri.scheme = bufp;
+	memcpy(bufp, scheme->prefix, scheme->len);
+	bufp += scheme->len;
+	*bufp = 0;
+	bufp++;
+	/* The scheme list is just the scheme itself */
+	bufp = ALIGN(bufp);
+	sl = (char **) (void *) bufp;
+	bufp += 2 * sizeof(char *);
+	sl[0] = (char *) p->iri.scheme;
+	sl[1] = NULL;
+	p->iri.schemelist = (const char **) sl;
+	p->iri.nschemes = 1;
+	src += scheme->plen;
+	if(scheme->flags & IRI_SCHEME_AUTHORITY)
+	{
+		if(scheme->flags & IRI_SCHEME_USERINFO)
+		{
+			for(t = src; *t && *t != '@' && *t != '/' && *t != '?' && *t != '#'; t++);
+			if(*t == '@')
+			{
+				/* user[;auth][:password]@ */
+				bufp = ALIGN(bufp);
+				p->iri.user = bufp;
+				while(src < t && *src != ';' && *src != ':')
+				{
+					src = iri__copychar_decode(&bufp, src, 0);
+				}
+				*bufp = 0;
+				bufp++;
+				if(*src == ';')
+				{
+					src++;
+					bufp = ALIGN(bufp);
+					p->iri.auth = bufp;
+					while(src < t && *src != ':')
+					{
+						/* Don't decode, so it can be extracted properly */
+						src = iri__copychar(&bufp, src);
+					}
+					*bufp = 0;
+					bufp++;
+				}
+				if(*src == ':')
+				{
+					src++;
+					bufp = ALIGN(bufp);
+					p->iri.password = bufp;
+					while(src < t)
+					{
+						src = iri__copychar_decode(&bufp, src, 0);
+					}
+					*bufp = 0;
+					bufp++;
+				}
+				src = t + 1;
+			}
+		}
+		bufp = ALIGN(bufp);
+		p->iri.host = bufp;
+		if(*src == '[')
+		{
+			/* IP-literal, which will contain colons */
+			while(*src && *src != ']' && *src != '/' && *src != '?' && *src != '#')
+			{
+				src = iri__copychar(&bufp, src);
+			}
+			if(*src == ']')
+			{
+				src = iri__copychar(&bufp, src);
+			}
+		}
+		while(*src && *src != ':' && *src != '/' && *src != '?' && *src != '#')
+		{
+			src = iri__copychar_decode(&bufp, src, 0);
+		}
+		*bufp = 0;
+		bufp++;
+		if(*src == ':')
+		{
+			src++;
+			endp = (char *) src;
+			p->iri.port = strtol(src, &endp, 10);
+			src = endp;
+		}
+	}
+	else if(*src && *src != '/' && *src != '?' && *src != '#')
+	{
+		/* Opaque path, e.g. urn:isbn:... */
+		bufp = ALIGN(bufp);
+		p->iri.path = bufp;
+		while(*src && *src != '?' && *src != '#')
+		{
+			src = iri__copychar_decode(&bufp, src, 0);
+		}
+		*bufp = 0;
+		bufp++;
+	}
+	if(0 == p->iri.port)
+	{
+		p->iri.port = scheme->port;
+	}
+	bufp = iri__parse_path(p, bufp, src);
+	p->used = bufp - bufstart;
+	return p;
+}
+
 iri_t *
 iri_parse(const char *src)
 {
@@ -196,7 +384,12 @@ iri_parse(const char *src)
 	char *bufstart, *endp, *bufp, **sl;
 	const char *at, *colon, *slash, *t;
 	size_t buflen, sc, cp;
+	const struct iri_scheme_info *scheme;
 	
+	if(NULL != (scheme = iri__scheme_match(src)))
+	{
+		return iri__parse_scheme(src, scheme);
+	}
 	if(NULL == (p = (iri_t *) calloc(1, sizeof(iri_t))))
 	{
 		return NULL;
@@ -309,6 +502,7 @@ iri_parse(const char *src)
 		if(!*src)
 		{
 			/* No host part */
+			p->used = bufp - bufstart;
 			return p;
 		}
 		if(*src == '@')
@@ -410,53 +604,11 @@ iri_parse(const char *src)
 		p->iri.port = strtol(src, &endp, 10);
 		src = endp;
 	}
-	if(*src == '/')
+	bufp = iri__parse_path(p, bufp, src);
+	if(0 == p->iri.port && NULL != (scheme = iri__scheme_find(p->iri.scheme)))
 	{
-		bufp = ALIGN(bufp);
-		p->iri.path = bufp;
-		while(*src && *src != '?' && *src != '#')
-		{
-			src = iri__copychar_decode(&bufp, src, 0);
-		}
-		*bufp = 0;
-		bufp++;
-	}
-	if(*src == '?')
-	{
-		bufp = ALIGN(bufp);
-		p->iri.query = bufp;
-		src++;
-		while(*src && *src != '#')
-		{
-			/* Don't actually decode the query itself, otherwise it
-			 * can't be reliably split */
-			src = iri__copychar(&bufp, src);
-		}
-		*bufp = 0;
-		bufp++;
-	}
-	if(*src == '#')
-	{
-		bufp = ALIGN(bufp);
-		p->iri.anchor = bufp; 
-		while(*src)
-		{
-			src = iri__copychar_decode(&bufp, src, 0);
-		}
-		*bufp = 0;
-		bufp++;
-	}
-	if(*src)
-	{
-		/* Still stuff left? It must be a path... of sorts */
-		bufp = ALIGN(bufp);
-		p->iri.path = bufp; 
-		while(*src && *src != '?' && *src != '#')
-		{
-			src = iri__copychar_decode(&bufp, src, 0);
-		}
-		*bufp = 0;
-		bufp++;
+		p->iri.port = scheme->port;
 	}
+	p->used = bufp - bufstart;
 	return p;
 }
@@ -0,0 +1,210 @@
+/*
+ * libiri: An IRI/URI/URL parsing library
+ * @(#) $Id$
+ */
+
+/*
+ * Copyright (c) 2005, 2008 Mo McRoberts.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ * 3. The names of the author(s) of this software may not be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, 
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY 
+ * AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * AUTHORS OF THIS SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS 
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <pthread.h>
+#include <strings.h>
+
+#include "p_libiri.h"
+
+#undef SCHEME_MAX
+#define SCHEME_MAX 64
+
+#define W8(a, b, c, d, e, f, g, h) \
+	((uint64_t) (a) | ((uint64_t) (b) << 8) | ((uint64_t) (c) << 16) | ((uint64_t) (d) << 24) | \
+	((uint64_t) (e) << 32) | ((uint64_t) (f) << 40) | ((uint64_t) (g) << 48) | ((uint64_t) (h) << 56))
+#define M8(n) ((n) >= 8 ? ~(uint64_t) 0 : ((uint64_t) 1 << ((n) * 8)) - 1)
+
+#define WEB (IRI_SCHEME_AUTHORITY|IRI_SCHEME_USERINFO)
+
+/* Entries are never modified once published. Readers load nschemes and
+ * then each slot's pointer with acquire semantics; a new scheme is added
+ * by filling in a fresh entry and then bumping nschemes, and a scheme is
+ * re-registered by storing a pointer to a replacement entry into its
+ * slot. Superseded entries can't be freed, as a reader may still be using
+ * one, so they're moved to the retired list instead. That's what lets
+ * iri_parse() read the table without taking the lock.
+ */
+static struct iri_scheme_info iri__builtin[] =
+{
+	{ "http://", 4, 7, 80, WEB, W8('h', 't', 't', 'p', ':', '/', '/', 0), M8(7), NULL },
+	{ "https://", 5, 8, 443, WEB, W8('h', 't', 't', 'p', 's', ':', '/', '/'), M8(8), NULL },
+	{ "ws://", 2, 5, 80, WEB, W8('w', 's', ':', '/', '/', 0, 0, 0), M8(5), NULL },
+	{ "wss://", 3, 6, 443, WEB, W8('w', 's', 's', ':', '/', '/', 0, 0), M8(6), NULL },
+	{ "ftp://", 3, 6, 21, WEB, W8('f', 't', 'p', ':', '/', '/', 0, 0), M8(6), NULL }
+};
+static struct iri_scheme_info *iri__schemes[SCHEME_MAX] =
+{
+	&iri__builtin[0], &iri__builtin[1], &iri__builtin[2], &iri__builtin[3], &iri__builtin[4]
+};
+static size_t iri__nschemes = 5;
+static struct iri_scheme_info *iri__retired;
+/* Bumped whenever the table changes, so that parse caches know to
+ * discard results produced under the old one (see cache.c)
+ */
+unsigned long iri__scheme_gen;
+static pthread_mutex_t iri__scheme_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static inline uint64_t
+iri__scheme_word(const char *src, size_t *len)
+{
+	uint64_t w;
+	size_t c;
+	
+	w = 0;
+	for(c = 0; c < 8 && src[c]; c++)
+	{
+		w |= (uint64_t) (unsigned char) src[c] << (c * 8);
+	}
+	*len = c;
+	return w;
+}
+
+/* Return the registered scheme whose prefix src begins with, if any */
+const struct iri_scheme_info *
+iri__scheme_match(const char *src)
+{
+	const struct iri_scheme_info *s;
+	uint64_t w;
+	size_t len, c, n;
+	
+	w = iri__scheme_word(src, &len);
+	n = __atomic_load_n(&iri__nschemes, __ATOMIC_ACQUIRE);
+	for(c = 0; c < n; c++)
+	{
+		s = __atomic_load_n(&iri__schemes[c], __ATOMIC_ACQUIRE);
+		if((w & s->mask) == s->word &&
+			(s->plen <= 8 || (8 == len && 0 == strncmp(src + 8, s->prefix + 8, s->plen - 8))))
+		{
+			return s;
+		}
+	}
+	return NULL;
+}
+
+/* Return the registered scheme with the given name, ignoring case */
+const struct iri_scheme_info *
+iri__scheme_find(const char *name)
+{
+	const struct iri_scheme_info *s;
+	size_t c, n;
+	
+	if(NULL == name)
+	{
+		return NULL;
+	}
+	n = __atomic_load_n(&iri__nschemes, __ATOMIC_ACQUIRE);
+	for(c = 0; c < n; c++)
+	{
+		s = __atomic_load_n(&iri__schemes[c], __ATOMIC_ACQUIRE);
+		if(0 == strncasecmp(name, s->prefix, s->len) && !name[s->len])
+		{
+			return s;
+		}
+	}
+	return NULL;
+}
+
+/* Register (or re-register) a scheme, so that IRIs beginning with it are
+ * handled by the fast-path parser. flags is a combination of
+ * IRI_SCHEME_AUTHORITY (the scheme is followed by "//" and a host) and
+ * IRI_SCHEME_USERINFO (the authority may include user[;auth][:password]@);
+ * default_port is filled in when an IRI doesn't specify one. Returns 0 on
+ * success, or -1 if the name is invalid or the table is full.
+ */
+int
+iri_scheme_register(const char *name, int default_port, unsigned int flags)
+{
+	struct iri_scheme_info *s, *old;
+	size_t len, c, slot;
+	
+	len = strlen(name);
+	if(!len || !IRI__CTYPE(name[0], IRI__CT_ALPHA) || len + 4 > IRI__SCHEME_PREFIXLEN)
+	{
+		return -1;
+	}
+	for(c = 1; c < len; c++)
+	{
+		if(!IRI__CTYPE(name[c], IRI__CT_SCHEME))
+		{
+			return -1;
+		}
+	}
+	pthread_mutex_lock(&iri__scheme_lock);
+	/* Existing entries are matched exactly, as that's how they're used */
+	old = NULL;
+	for(slot = 0; slot < iri__nschemes; slot++)
+	{
+		if(iri__schemes[slot]->len == len && 0 == memcmp(iri__schemes[slot]->prefix, name, len))
+		{
+			old = iri__schemes[slot];
+			break;
+		}
+	}
+	if(NULL != old && old->port == default_port && old->flags == flags)
+	{
+		/* Nothing would change */
+		pthread_mutex_unlock(&iri__scheme_lock);
+		return 0;
+	}
+	if((NULL == old && SCHEME_MAX == iri__nschemes) ||
+		NULL == (s = (struct iri_scheme_info *) calloc(1, sizeof(struct iri_scheme_info))))
+	{
+		pthread_mutex_unlock(&iri__scheme_lock);
+		return -1;
+	}
+	memcpy(s->prefix, name, len);
+	strcpy(s->prefix + len, (flags & IRI_SCHEME_AUTHORITY) ? "://" : ":");
+	s->len = len;
+	s->plen = strlen(s->prefix);
+	s->word = iri__scheme_word(s->prefix, &c);
+	s->mask = M8(c);
+	s->port = default_port;
+	s->flags = flags;
+	__atomic_store_n(&iri__schemes[slot], s, __ATOMIC_RELEASE);
+	if(NULL == old)
+	{
+		__atomic_store_n(&iri__nschemes, iri__nschemes + 1, __ATOMIC_RELEASE);
+	}
+	else
+	{
+		/* Readers are no longer handed old, but may still be using it */
+		old->retired = iri__retired;
+		iri__retired = old;
+	}
+	__atomic_add_fetch(&iri__scheme_gen, 1, __ATOMIC_RELEASE);
+	pthread_mutex_unlock(&iri__scheme_lock);
+	return 0;
+}
@@ -0,0 +1,230 @@
+/*
+ * libiri: An IRI/URI/URL parsing library
+ * @(#) $Id$
+ */
+
+/*
+ * Copyright (c) 2005, 2008 Mo McRoberts.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ * 3. The names of the author(s) of this software may not be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, 
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY 
+ * AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * AUTHORS OF THIS SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS 
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "p_libiri.h"
+
+static inline void
+iri__rebase(const char **ptr, size_t oldbase, size_t nbytes, char *newbase)
+{
+	if(NULL != *ptr && (size_t) *ptr - oldbase < nbytes)
+	{
+		*ptr = newbase + ((size_t) *ptr - oldbase);
+	}
+}
+
+/* Enlarge the buffer to hold at least needed bytes, doubling it if that
+ * is bigger, and update every pointer which referred to the old one.
+ */
+static int
+iri__grow(iri_t *iri, size_t needed)
+{
+	size_t oldbase, nbytes, c;
+	char *base;
+	
+	nbytes = iri->nbytes * 2;
+	if(nbytes < needed)
+	{
+		nbytes = needed;
+	}
+	oldbase = (size_t) iri->base;
+	if(NULL == (base = (char *) realloc(iri->base, nbytes)))
+	{
+		return -1;
+	}
+	iri__rebase(&(iri->iri.display), oldbase, iri->nbytes, base);
+	iri__rebase(&(iri->iri.scheme), oldbase, iri->nbytes, base);
+	iri__rebase(&(iri->iri.user), oldbase, iri->nbytes, base);
+	iri__rebase(&(iri->iri.auth), oldbase, iri->nbytes, base);
+	iri__rebase(&(iri->iri.password), oldbase, iri->nbytes, base);
+	iri__rebase(&(iri->iri.host), oldbase, iri->nbytes, base);
+	iri__rebase(&(iri->iri.path), oldbase, iri->nbytes, base);
+	iri__rebase(&(iri->iri.query), oldbase, iri->nbytes, base);
+	iri__rebase(&(iri->iri.anchor), oldbase, iri->nbytes, base);
+	if(NULL != iri->iri.schemelist)
+	{
+		iri__rebase((const char **) &(iri->iri.schemelist), oldbase, iri->nbytes, base);
+		for(c = 0; c < iri->iri.nschemes; c++)
+		{
+			iri__rebase(&(iri->iri.schemelist[c]), oldbase, iri->nbytes, base);
+		}
+	}
+	iri->base = base;
+	iri->nbytes = nbytes;
+	return 0;
+}
+
+/* Replace the component pointed to by field with len bytes from value.
+ * The existing storage is reused if the new value fits, then any slack at
+ * the end of the buffer, and the buffer is only grown as a last resort.
+ */
+static int
+iri__set(iri_t *iri, const char **field, const char *value, size_t len)
+{
+	size_t voff;
+	char *dest;
+	
+	if(0 != iri->refs)
+	{
+		/* Shared (e.g., by the parse cache) and so read-only */
+		return -1;
+	}
+	if(NULL == value)
+	{
+		*field = NULL;
+		return 0;
+	}
+	if(NULL != *field && (size_t) *field - (size_t) iri->base < iri->nbytes && strlen(*field) >= len)
+	{
+		dest = (char *) *field;
+	}
+	else
+	{
+		if(iri->used + len + 1 > iri->nbytes)
+		{
+			/* value may itself live in the buffer we're about to move */
+			voff = (size_t) value - (size_t) iri->base;
+			if(0 != iri__grow(iri, iri->used + len + 1))
+			{
+				return -1;
+			}
+			if(voff < iri->used)
+			{
+				value = (const char *) iri->base + voff;
+			}
+		}
+		dest = (char *) iri->base + iri->used;
+		iri->used += len + 1;
+	}
+	memmove(dest, value, len);
+	dest[len] = 0;
+	*field = dest;
+	return 0;
+}
+
+/* Setters: values are stored as given, so the host and path should be
+ * in decoded form and the query in encoded form, as iri_parse() would
+ * produce them. Passing NULL removes the component. All return 0 on
+ * success, or -1 on allocation failure or if the IRI is shared.
+ */
+int
+iri_set_host(iri_t *iri, const char *host)
+{
+	return iri__set(iri, &(iri->iri.host), host, host ? strlen(host) : 0);
+}
+
+int
+iri_set_path(iri_t *iri, const char *path)
+{
+	return iri__set(iri, &(iri->iri.path), path, path ? strlen(path) : 0);
+}
+
+int
+iri_set_query(iri_t *iri, const char *query)
+{
+	return iri__set(iri, &(iri->iri.query), query, query ? strlen(query) : 0);
+}
+
+int
+iri_set_port(iri_t *iri, int port)
+{
+	if(0 != iri->refs)
+	{
+		return -1;
+	}
+	iri->iri.port = port;
+	return 0;
+}
+
+/* Remove every key[=value] parameter named key from the query, in place,
+ * returning the number removed (or -1 if the IRI is shared). The key is
+ * compared against the query as stored, i.e., still encoded.
+ */
+int
+iri_query_remove(iri_t *iri, const char *key)
+{
+	const char *src, *end, *name;
+	char *dest;
+	size_t klen, nlen;
+	int count;
+	
+	if(0 != iri->refs)
+	{
+		return -1;
+	}
+	if(NULL == iri->iri.query)
+	{
+		return 0;
+	}
+	if((size_t) iri->iri.query - (size_t) iri->base >= iri->nbytes)
+	{
+		/* Not ours to modify in place; take a copy first */
+		if(0 != iri__set(iri, &(iri->iri.query), iri->iri.query, strlen(iri->iri.query)))
+		{
+			return -1;
+		}
+	}
+	klen = strlen(key);
+	count = 0;
+	src = iri->iri.query;
+	dest = (char *) iri->iri.query;
+	while(*src)
+	{
+		for(end = src; *end && *end != '&'; end++);
+		name = src;
+		for(nlen = 0; name + nlen < end && name[nlen] != '='; nlen++);
+		if(nlen == klen && 0 == memcmp(name, key, klen))
+		{
+			count++;
+		}
+		else
+		{
+			if(dest != iri->iri.query)
+			{
+				*dest = '&';
+				dest++;
+			}
+			memmove(dest, src, end - src);
+			dest += end - src;
+		}
+		src = *end ? end + 1 : end;
+	}
+	*dest = 0;
+	if(!iri->iri.query[0])
+	{
+		iri->iri.query = NULL;
+	}
+	return count;
+}
@@ -0,0 +1,392 @@
+/*
+ * libiri: An IRI/URI/URL parsing library
+ * @(#) $Id$
+ */
+
+/*
+ * Copyright (c) 2005, 2008 Mo McRoberts.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ * 3. The names of the author(s) of this software may not be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, 
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY 
+ * AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * AUTHORS OF THIS SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS 
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "p_libiri.h"
+
+static inline int
+iri__vfail(const char *src, const char *p, size_t *err_offset)
+{
+	if(NULL != err_offset)
+	{
+		*err_offset = p - src;
+	}
+	return -1;
+}
+
+/* Return the length of the well-formed UTF-8 sequence at p if it encodes
+ * a character RFC 3987 permits (a ucschar, or an iprivate if allowed), or
+ * 0 if not: overlong forms, surrogates, C1 controls, noncharacters and
+ * stray continuation bytes are all rejected.
+ */
+static inline size_t
+iri__vutf8(const unsigned char *p, const unsigned char *end, int iprivate)
+{
+	unsigned long cp;
+	size_t n, c;
+	
+	if(p[0] >= 0xc2 && p[0] <= 0xdf)
+	{
+		n = 2;
+		cp = p[0] & 0x1f;
+	}
+	else if(p[0] >= 0xe0 && p[0] <= 0xef)
+	{
+		n = 3;
+		cp = p[0] & 0x0f;
+	}
+	else if(p[0] >= 0xf0 && p[0] <= 0xf4)
+	{
+		n = 4;
+		cp = p[0] & 0x07;
+	}
+	else
+	{
+		return 0;
+	}
+	if((size_t) (end - p) < n)
+	{
+		return 0;
+	}
+	for(c = 1; c < n; c++)
+	{
+		if(0x80 != (p[c] & 0xc0))
+		{
+			return 0;
+		}
+		cp = (cp << 6) | (p[c] & 0x3f);
+	}
+	if((3 == n && cp < 0x800) || (4 == n && (cp < 0x10000 || cp > 0x10ffff)))
+	{
+		return 0;
+	}
+	/* ucschar */
+	if((cp >= 0xa0 && cp <= 0xd7ff) || (cp >= 0xf900 && cp <= 0xfdcf) || (cp >= 0xfdf0 && cp <= 0xffef) ||
+		(cp >= 0x10000 && cp <= 0xefffd && (cp & 0xffff) <= 0xfffd && (cp < 0xe0000 || cp >= 0xe1000)))
+	{
+		return n;
+	}
+	/* iprivate */
+	if(iprivate && ((cp >= 0xe000 && cp <= 0xf8ff) || (cp >= 0xf0000 && (cp & 0xffff) <= 0xfffd)))
+	{
+		return n;
+	}
+	return 0;
+}
+
+/* Skip over characters belonging to the class mask, along with any
+ * percent-encoded octets and UTF-8 sequences, returning a pointer to the
+ * first character which doesn't belong (or end). iprivate permits the
+ * private-use characters which RFC 3987 allows only in the query.
+ */
+static inline const char *
+iri__vspan(const char *p, const char *end, unsigned short mask, int lenient, int iprivate)
+{
+	unsigned char c;
+	size_t n;
+	
+	if(lenient)
+	{
+		mask |= IRI__CT_LAX;
+	}
+	while(p < end)
+	{
+		c = (unsigned char) *p;
+		if(c < 128 && (iri__chartab[c] & mask))
+		{
+			p++;
+		}
+		else if(c >= 128)
+		{
+			if(lenient)
+			{
+				p++;
+			}
+			else if(0 != (n = iri__vutf8((const unsigned char *) p, (const unsigned char *) end, iprivate)))
+			{
+				p += n;
+			}
+			else
+			{
+				break;
+			}
+		}
+		else if('%' == c)
+		{
+			if(p + 2 < end && IRI__CTYPE(p[1], IRI__CT_HEX) && IRI__CTYPE(p[2], IRI__CT_HEX))
+			{
+				p += 3;
+			}
+			else if(lenient)
+			{
+				/* iri_parse() passes a stray '%' through untouched */
+				p++;
+			}
+			else
+			{
+				break;
+			}
+		}
+		else
+		{
+			break;
+		}
+	}
+	return p;
+}
+
+/* Check for an IPv4address (RFC 3986 section 3.2.2) at *p, advancing *p
+ * past it. Returns 0 if valid, or -1 with *p left where it goes wrong.
+ */
+static int
+iri__vipv4(const char **p, const char *end)
+{
+	const char *s;
+	int octets, v, n;
+	
+	s = *p;
+	for(octets = 0; octets < 4; octets++)
+	{
+		if(octets)
+		{
+			if(s >= end || '.' != *s)
+			{
+				*p = s;
+				return -1;
+			}
+			s++;
+		}
+		for(v = 0, n = 0; s < end && IRI__CTYPE(*s, IRI__CT_DIGIT); s++, n++)
+		{
+			if((n && !v) || (v = v * 10 + (*s - '0')) > 255)
+			{
+				/* Leading zero, or out of range */
+				*p = s;
+				return -1;
+			}
+		}
+		if(!n)
+		{
+			*p = s;
+			return -1;
+		}
+	}
+	*p = s;
+	return 0;
+}
+
+/* Check the contents of an IP-literal, i.e., an IPv6address or an
+ * IPvFuture, occupying [*p, end). Returns 0 if valid, or -1 with *p set
+ * to where it goes wrong.
+ */
+static int
+iri__vipliteral(const char **p, const char *end)
+{
+	const char *s, *g;
+	int groups, elided, n;
+	
+	s = *p;
+	if(s < end && ('v' == *s || 'V' == *s))
+	{
+		/* "v" 1*HEXDIG "." 1*( unreserved / sub-delims / ":" ) */
+		for(s++, n = 0; s < end && IRI__CTYPE(*s, IRI__CT_HEX); s++, n++);
+		if(!n || s >= end || '.' != *s)
+		{
+			*p = s;
+			return -1;
+		}
+		for(s++, n = 0; s < end && IRI__CTYPE(*s, IRI__CT_USERINFO); s++, n++);
+		*p = s;
+		return (n && s == end) ? 0 : -1;
+	}
+	groups = 0;
+	elided = 0;
+	if(s + 1 < end && ':' == s[0] && ':' == s[1])
+	{
+		elided = 1;
+		s += 2;
+	}
+	while(s < end)
+	{
+		g = s;
+		for(n = 0; s < end && n < 4 && IRI__CTYPE(*s, IRI__CT_HEX); s++, n++);
+		if(s < end && '.' == *s)
+		{
+			/* Trailing IPv4address, standing in for the last two groups */
+			if(0 != iri__vipv4(&g, end) || g != end)
+			{
+				*p = g;
+				return -1;
+			}
+			groups += 2;
+			s = end;
+			break;
+		}
+		if(!n || ++groups > 8 || (s < end && (':' != *s || s + 1 == end)))
+		{
+			*p = (n && groups > 8) ? g : s;
+			return -1;
+		}
+		if(s == end)
+		{
+			break;
+		}
+		s++;
+		if(':' == *s)
+		{
+			if(elided)
+			{
+				*p = s;
+				return -1;
+			}
+			elided = 1;
+			s++;
+		}
+	}
+	if(elided ? groups > 7 : groups != 8)
+	{
+		/* Wrong number of groups; the closing bracket is as good as any */
+		*p = end;
+		return -1;
+	}
+	return 0;
+}
+
+/* Check that len bytes at src form a syntactically valid IRI reference,
+ * without allocating anything. Returns 0 if so, or -1 with the offset of
+ * the first offending byte stored in *err_offset (if non-NULL).
+ *
+ * IRI_VALIDATE_STRICT follows the RFC 3986 grammar, extended per RFC 3987
+ * to accept well-formed UTF-8 ucschar (and, in the query, iprivate)
+ * characters outside of the scheme and port. IRI_VALIDATE_LENIENT
+ * additionally accepts the things iri_parse() lets through: any octet
+ * >= 0x80, malformed percent-escapes, visible ASCII which should have been
+ * escaped (e.g. '{', '|', '[' in a path) and a colon in the first segment
+ * of a relative reference. IP-literals ("[...]" hosts) are checked against
+ * the IPv6address and IPvFuture rules in either mode.
+ */
+int
+iri_validate(const char *src, size_t len, unsigned int flags, size_t *err_offset)
+{
+	const char *p, *end, *t, *at, *aend;
+	int lenient, noscheme, authority;
+	
+	lenient = (flags & IRI_VALIDATE_LENIENT) ? 1 : 0;
+	p = src;
+	end = src + len;
+	noscheme = 1;
+	authority = 0;
+	/* scheme ":" */
+	if(p < end && IRI__CTYPE(*p, IRI__CT_ALPHA))
+	{
+		for(t = p + 1; t < end && IRI__CTYPE(*t, IRI__CT_SCHEME); t++);
+		if(t < end && ':' == *t)
+		{
+			p = t + 1;
+			noscheme = 0;
+		}
+	}
+	/* "//" [ userinfo "@" ] host [ ":" port ] */
+	if(p + 1 < end && '/' == p[0] && '/' == p[1])
+	{
+		authority = 1;
+		p += 2;
+		for(aend = p; aend < end && '/' != *aend && '?' != *aend && '#' != *aend; aend++);
+		if(NULL != (at = (const char *) memchr(p, '@', aend - p)))
+		{
+			t = iri__vspan(p, at, IRI__CT_USERINFO, lenient, 0);
+			if(t != at)
+			{
+				return iri__vfail(src, t, err_offset);
+			}
+			p = at + 1;
+		}
+		if(p < aend && '[' == *p)
+		{
+			/* IP-literal, checked strictly in either mode */
+			if(NULL == (at = (const char *) memchr(p + 1, ']', aend - p - 1)))
+			{
+				return iri__vfail(src, aend, err_offset);
+			}
+			t = p + 1;
+			if(0 != iri__vipliteral(&t, at))
+			{
+				return iri__vfail(src, t, err_offset);
+			}
+			t = at + 1;
+		}
+		else
+		{
+			t = iri__vspan(p, aend, IRI__CT_REGNAME, lenient, 0);
+		}
+		if(t < aend && ':' == *t)
+		{
+			for(t++; t < aend && IRI__CTYPE(*t, IRI__CT_DIGIT); t++);
+		}
+		if(t != aend)
+		{
+			return iri__vfail(src, t, err_offset);
+		}
+		p = aend;
+	}
+	/* path */
+	t = iri__vspan(p, end, IRI__CT_PATH, lenient, 0);
+	if(noscheme && !authority && !lenient)
+	{
+		/* path-noscheme: the first segment can't contain a colon */
+		for(; p < t && '/' != *p; p++)
+		{
+			if(':' == *p)
+			{
+				return iri__vfail(src, p, err_offset);
+			}
+		}
+	}
+	p = t;
+	/* [ "?" query ] [ "#" fragment ] */
+	if(p < end && '?' == *p)
+	{
+		p = iri__vspan(p + 1, end, IRI__CT_QUERY, lenient, 1);
+	}
+	if(p < end && '#' == *p)
+	{
+		p = iri__vspan(p + 1, end, IRI__CT_QUERY, lenient, 0);
+	}
+	if(p != end)
+	{
+		return iri__vfail(src, p, err_offset);
+	}
+	return 0;
+}
@@ -0,0 +1,112 @@
+/*
+ * libiri: An IRI/URI/URL parsing library
+ * @(#) $Id$
+ */
+
+/*
+ * Copyright (c) 2005, 2008 Mo McRoberts.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ * 3. The names of the author(s) of this software may not be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, 
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY 
+ * AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * AUTHORS OF THIS SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF 
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS 
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iri.h"
+
+/* Parse IRIs read from standard input, one per line, keeping every result
+ * resident in both representations, and report the memory used per IRI.
+ */
+int
+main(int argc, char **argv)
+{
+	char buf[4096];
+	iri_t **iris;
+	iri_compact_t **compacts;
+	size_t n, alloc, len, raw, full, compact;
+	
+	if(argc != 1)
+	{
+		fprintf(stderr, "Usage: %s < FILE\n", argv[0]);
+		exit(EXIT_FAILURE);
+	}
+	iris = NULL;
+	compacts = NULL;
+	n = alloc = 0;
+	raw = full = compact = 0;
+	while(NULL != fgets(buf, sizeof(buf), stdin))
+	{
+		len = strlen(buf);
+		while(len && (buf[len - 1] == '\n' || buf[len - 1] == '\r'))
+		{
+			buf[--len] = 0;
+		}
+		if(!len)
+		{
+			continue;
+		}
+		if(n == alloc)
+		{
+			alloc = alloc ? alloc * 2 : 1024;
+			iris = (iri_t **) realloc(iris, alloc * sizeof(iri_t *));
+			compacts = (iri_compact_t **) realloc(compacts, alloc * sizeof(iri_compact_t *));
+			if(NULL == iris || NULL == compacts)
+			{
+				perror("realloc");
+				exit(EXIT_FAILURE);
+			}
+		}
+		if(NULL == (iris[n] = iri_parse(buf)) || NULL == (compacts[n] = iri_compact(iris[n])))
+		{
+			fprintf(stderr, "%s: failed to parse IRI: %s\n", argv[0], buf);
+			exit(EXIT_FAILURE);
+		}
+		raw += len;
+		full += iri_size(iris[n]);
+		compact += iri_compact_size(compacts[n]);
+		n++;
+	}
+	if(!n)
+	{
+		fprintf(stderr, "%s: no IRIs read\n", argv[0]);
+		exit(EXIT_FAILURE);
+	}
+	printf("    IRIs: %lu\n", (unsigned long) n);
+	printf("     raw: %.1f bytes/IRI\n", (double) raw / n);
+	printf("   iri_t: %.1f bytes/IRI\n", (double) full / n);
+	printf(" compact: %.1f bytes/IRI\n", (double) compact / n);
+	while(n--)
+	{
+		iri_destroy(iris[n]);
+		iri_compact_destroy(compacts[n]);
+	}
+	free(iris);
+	free(compacts);
+	return 0;
+}
@@ -36,6 +36,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 
 #include "iri.h"
@@ -44,7 +45,7 @@ int
 main(int argc, char **argv)
 {
 	iri_t *iri;
-	size_t c;
+	size_t c, off;
 	
 	if(argc != 2)
 	{
@@ -65,5 +66,21 @@ main(int argc, char **argv)
 	printf("    path: %s\n", iri->path);
 	printf("   query: %s\n", iri->query);
 	printf("  anchor: %s\n", iri->anchor);
+	if(iri_validate(argv[1], strlen(argv[1]), IRI_VALIDATE_STRICT, &off))
+	{
+		printf("  strict: invalid at offset %d\n", (int) off);
+	}
+	else
+	{
+		printf("  strict: valid\n");
+	}
+	if(iri_validate(argv[1], strlen(argv[1]), IRI_VALIDATE_LENIENT, &off))
+	{
+		printf(" lenient: invalid at offset %d\n", (int) off);
+	}
+	else
+	{
+		printf(" lenient: valid\n");
+	}
 	return 0;
 }